@@ -0,0 +1,1974 @@
+#include "sarcasm.h"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <cctype>
+#include <sstream>
+#include <set>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <thread>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "llvm/ADT/APFloat.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/CFG.h"
+#include "llvm/CodeGen/ParallelCG.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Mangler.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Type.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "llvm/ExecutionEngine/GenericValue.h"
+#include "llvm/ExecutionEngine/MCJIT.h"
+
+using namespace llvm;
+
+// SarcasmLang Grammar:
+// program    := line*
+// line       := INSULT ':' statement
+// statement  := assignment | ifstmt | whilestmt | printstmt
+// assignment := IDENTIFIER '=' expression
+// ifstmt     := 'obviously' expression 'then' '{' line* '}'
+// whilestmt  := 'whatever' expression 'do' '{' line* '}'
+// printstmt  := ('show' | 'display' | 'reveal' | 'output') expression
+// expression := term (('plus' | 'minus' | '+' | '-') term)*
+// term       := factor (('times' | 'divided_by' | '*' | '/') factor)*
+// factor     := NUMBER | IDENTIFIER | '(' expression ')'
+
+enum TokenType {
+    TOKEN_EOF,
+    TOKEN_NUMBER,
+    TOKEN_IDENTIFIER,
+    TOKEN_ASSIGN,
+    TOKEN_COLON,
+    TOKEN_LPAREN,
+    TOKEN_RPAREN,
+    TOKEN_LBRACE,
+    TOKEN_RBRACE,
+    TOKEN_PLUS,
+    TOKEN_MINUS,
+    TOKEN_MULTIPLY,
+    TOKEN_DIVIDE,
+    TOKEN_OBVIOUSLY,
+    TOKEN_WHATEVER,
+    TOKEN_THEN,
+    TOKEN_DO,
+    TOKEN_SHOW,
+    TOKEN_LESS,
+    TOKEN_GREATER,
+    TOKEN_INSULT,
+    TOKEN_WORD_PLUS,
+    TOKEN_WORD_MINUS,
+    TOKEN_WORD_MULTIPLY,
+    TOKEN_WORD_DIVIDE
+};
+
+// Comprehensive list of creative insults for SarcasmLang
+std::set<std::string> insults = {
+    "idiot", "moron", "dummy", "fool", "genius", "einstein", "smartass", "brainiac",
+    "doofus", "numbskull", "dimwit", "nincompoop", "bonehead", "knucklehead",
+    "airhead", "birdbrain", "blockhead", "chucklehead", "fathead", "meathead",
+    "pinhead", "hotshot", "wiseguy", "smarty", "clever_clogs", "know_it_all",
+    "rocket_scientist", "mastermind", "prodigy", "savant", "intellectual",
+    "scholar", "philosopher", "thinker", "genius_level", "big_brain",
+    "smooth_brain", "pea_brain", "walnut_brain", "goldfish_brain",
+    "caveman", "neanderthal", "primitive", "amateur", "rookie", "newbie",
+    "peasant", "pleb", "scrub", "noob", "casual", "try_hard", "wannabe"
+};
+
+struct Token {
+    TokenType type;
+    std::string value;
+    double numValue;
+};
+
+class SarcasmLexer {
+private:
+    std::string input;
+    size_t pos;
+    size_t firstLine;
+    std::ostream& diagnostics;
+    bool stoppedEarly = false;
+    
+    std::string readWord() {
+        std::string word;
+        while (pos < input.length() && 
+               (std::isalnum(static_cast<unsigned char>(input[pos])) || input[pos] == '_')) {
+            word += static_cast<char>(std::tolower(static_cast<unsigned char>(input[pos++])));
+        }
+        return word;
+    }
+    
+public:
+    // `firstLine` is the line number `text` starts at within the whole source
+    SarcasmLexer(const std::string& text, std::ostream& diagnostics = std::cerr, size_t firstLine = 1)
+        : input(text), pos(0), firstLine(firstLine), diagnostics(diagnostics) {}
+    
+    // True if lexing ended at a stray character rather than the end of input
+    bool truncated() const {
+        return stoppedEarly;
+    }
+    
+    Token nextToken() {
+        while (pos < input.length() && std::isspace(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        
+        if (pos >= input.length()) {
+            return {TOKEN_EOF, "", 0};
+        }
+        
+        char current = input[pos];
+        
+        if (std::isdigit(static_cast<unsigned char>(current))) {
+            std::string number;
+            while (pos < input.length() && 
+                   (std::isdigit(static_cast<unsigned char>(input[pos])) || input[pos] == '.')) {
+                number += input[pos++];
+            }
+            return {TOKEN_NUMBER, number, std::stod(number)};
+        }
+        
+        if (std::isalpha(static_cast<unsigned char>(current)) || current == '_') {
+            std::string word = readWord();
+            
+            // Check for keywords
+            if (word == "obviously") return {TOKEN_OBVIOUSLY, word, 0};
+            if (word == "whatever") return {TOKEN_WHATEVER, word, 0};
+            if (word == "then") return {TOKEN_THEN, word, 0};
+            if (word == "do") return {TOKEN_DO, word, 0};
+            if (word == "show" || word == "display" || word == "reveal" || word == "output") {
+                return {TOKEN_SHOW, word, 0};
+            }
+            if (word == "plus") return {TOKEN_WORD_PLUS, word, 0};
+            if (word == "minus") return {TOKEN_WORD_MINUS, word, 0};
+            if (word == "times") return {TOKEN_WORD_MULTIPLY, word, 0};
+            if (word == "divided_by") return {TOKEN_WORD_DIVIDE, word, 0};
+            
+            // Check if it's an insult
+            if (insults.find(word) != insults.end()) {
+                return {TOKEN_INSULT, word, 0};
+            }
+            
+            return {TOKEN_IDENTIFIER, word, 0};
+        }
+        
+        pos++;
+        switch (current) {
+            case '=': return {TOKEN_ASSIGN, "=", 0};
+            case ':': return {TOKEN_COLON, ":", 0};
+            case '(': return {TOKEN_LPAREN, "(", 0};
+            case ')': return {TOKEN_RPAREN, ")", 0};
+            case '{': return {TOKEN_LBRACE, "{", 0};
+            case '}': return {TOKEN_RBRACE, "}", 0};
+            case '+': return {TOKEN_PLUS, "+", 0};
+            case '-': return {TOKEN_MINUS, "-", 0};
+            case '*': return {TOKEN_MULTIPLY, "*", 0};
+            case '/': return {TOKEN_DIVIDE, "/", 0};
+            case '<': return {TOKEN_LESS, "<", 0};
+            case '>': return {TOKEN_GREATER, ">", 0};
+            default: {
+                // Anything unrecognised ends the program right here
+                stoppedEarly = true;
+                size_t line = firstLine + std::count(input.begin(), input.begin() + (pos - 1), '\n');
+                diagnostics << "neanderthal: What is ";
+                if (std::isprint(static_cast<unsigned char>(current))) {
+                    diagnostics << "'" << current << "'";
+                } else {
+                    char code[8];
+                    std::snprintf(code, sizeof(code), "0x%02x", static_cast<unsigned char>(current));
+                    diagnostics << "byte " << code;
+                }
+                diagnostics << " doing on line " << line << "? This isn't a language you made up" << std::endl;
+                return {TOKEN_EOF, "", 0};
+            }
+        }
+    }
+};
+
+// Runtime hook behind show/display/reveal/output
+extern "C" void sarcasm_print(SarcasmRuntime* runtime, const char* format, double value) {
+    if (!runtime || !runtime->output) {
+        std::printf(format, value);
+        return;
+    }
+    char buffer[128];
+    int length = std::snprintf(buffer, sizeof(buffer), format, value);
+    if (length <= 0) return;
+    if (static_cast<size_t>(length) < sizeof(buffer)) {
+        runtime->output->append(buffer, length);
+        return;
+    }
+    // Huge numbers print with every digit; format again at full size
+    std::string text(length, '\0');
+    std::snprintf(&text[0], text.size() + 1, format, value);
+    runtime->output->append(text);
+}
+
+// Per-compilation LLVM state. Every program gets its own context so several
+// programs can be compiled and run side by side without sharing anything.
+struct CodeGenContext {
+    LLVMContext& context;
+    IRBuilder<> builder;
+    Module* module;
+    Function* function = nullptr;
+    Value* slots = nullptr;
+    Value* runtime = nullptr;
+    SwitchInst* dispatch = nullptr;     // Jumps to the loop a yielded program resumes at
+    BasicBlock* exitBlock = nullptr;    // Copies variables out and returns
+    PHINode* exitCode = nullptr;
+    std::map<std::string, AllocaInst*> namedValues;   // Allocas of the function being emitted
+    std::vector<std::string> variables; // Slot order, as seen by the host
+    std::map<std::string, size_t> slotIndex;
+    bool verbose = false;
+    bool yieldAtBackEdges = false;
+    int lineNum = 1;
+    int loopCount = 0;
+    
+    CodeGenContext(LLVMContext& context, Module* module)
+        : context(context), builder(context), module(module) {}
+    
+    // Every arithmetic instruction the builder emits carries these flags
+    void setNumericProfile(NumericProfile profile) {
+        FastMathFlags flags;
+        if (profile == NUMERIC_CONTRACT) {
+            flags.setAllowContract(true);
+        } else if (profile == NUMERIC_FAST) {
+            flags.setFast();
+        }
+        builder.setFastMathFlags(flags);
+    }
+    
+    // Variables live in entry-block allocas for the whole call; they are
+    // loaded from and stored back to the host slots around the program body.
+    AllocaInst* lookupVariable(const std::string& name) {
+        AllocaInst*& alloca = namedValues[name];
+        if (!alloca) {
+            IRBuilder<> tmpB(&function->getEntryBlock(), function->getEntryBlock().begin());
+            alloca = tmpB.CreateAlloca(Type::getDoubleTy(context), nullptr, name);
+            if (slotIndex.emplace(name, variables.size()).second) {
+                variables.push_back(name);
+            }
+        }
+        return alloca;
+    }
+    
+    Value* slotPointer(IRBuilder<>& b, const std::string& name) {
+        Type* doublePtrTy = Type::getDoublePtrTy(context);
+        Value* slotAddr = b.CreateConstInBoundsGEP1_64(doublePtrTy, slots, slotIndex[name]);
+        return b.CreateLoad(doublePtrTy, slotAddr, name + "_slot");
+    }
+};
+
+// Abstract Syntax Tree nodes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual Value* codegen(CodeGenContext& cg) = 0;
+};
+
+class NumberExprAST : public ASTNode {
+    double val;
+public:
+    NumberExprAST(double val) : val(val) {}
+    Value* codegen(CodeGenContext& cg) override;
+};
+
+class VariableExprAST : public ASTNode {
+    std::string name;
+public:
+    VariableExprAST(const std::string& name) : name(name) {}
+    Value* codegen(CodeGenContext& cg) override;
+};
+
+class BinaryExprAST : public ASTNode {
+    char op;
+    std::unique_ptr<ASTNode> lhs, rhs;
+public:
+    BinaryExprAST(char op, std::unique_ptr<ASTNode> lhs, std::unique_ptr<ASTNode> rhs)
+        : op(op), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+    Value* codegen(CodeGenContext& cg) override;
+};
+
+class AssignmentAST : public ASTNode {
+    std::string varName;
+    std::unique_ptr<ASTNode> expr;
+public:
+    AssignmentAST(const std::string& varName, std::unique_ptr<ASTNode> expr)
+        : varName(varName), expr(std::move(expr)) {}
+    Value* codegen(CodeGenContext& cg) override;
+};
+
+class PrintAST : public ASTNode {
+    std::unique_ptr<ASTNode> expr;
+    std::string printWord;
+public:
+    PrintAST(std::unique_ptr<ASTNode> expr, const std::string& printWord)
+        : expr(std::move(expr)), printWord(printWord) {}
+    Value* codegen(CodeGenContext& cg) override;
+};
+
+class IfAST : public ASTNode {
+    std::unique_ptr<ASTNode> condition;
+    std::vector<std::unique_ptr<ASTNode>> thenStmts;
+public:
+    IfAST(std::unique_ptr<ASTNode> condition, std::vector<std::unique_ptr<ASTNode>> thenStmts)
+        : condition(std::move(condition)), thenStmts(std::move(thenStmts)) {}
+    Value* codegen(CodeGenContext& cg) override;
+};
+
+class WhileAST : public ASTNode {
+    std::unique_ptr<ASTNode> condition;
+    std::vector<std::unique_ptr<ASTNode>> body;
+public:
+    WhileAST(std::unique_ptr<ASTNode> condition, std::vector<std::unique_ptr<ASTNode>> body)
+        : condition(std::move(condition)), body(std::move(body)) {}
+    Value* codegen(CodeGenContext& cg) override;
+};
+
+class SarcasmLineAST : public ASTNode {
+    std::string insult;
+    std::unique_ptr<ASTNode> statement;
+public:
+    SarcasmLineAST(const std::string& insult, std::unique_ptr<ASTNode> statement)
+        : insult(insult), statement(std::move(statement)) {}
+    Value* codegen(CodeGenContext& cg) override;
+};
+
+// Random insult generator for runtime fun
+std::string generateRandomInsult() {
+    static std::random_device rd;
+    static std::mt19937 gen(rd());
+    static std::vector<std::string> insultList(insults.begin(), insults.end());
+    std::uniform_int_distribution<> dis(0, static_cast<int>(insultList.size()) - 1);
+    return insultList[dis(gen)];
+}
+
+// Code generation implementations
+Value* NumberExprAST::codegen(CodeGenContext& cg) {
+    return ConstantFP::get(cg.context, APFloat(val));
+}
+
+Value* VariableExprAST::codegen(CodeGenContext& cg) {
+    AllocaInst* alloca = cg.lookupVariable(name);
+    return cg.builder.CreateLoad(Type::getDoubleTy(cg.context), alloca, name);
+}
+
+Value* BinaryExprAST::codegen(CodeGenContext& cg) {
+    Value* l = lhs->codegen(cg);
+    Value* r = rhs->codegen(cg);
+    if (!l || !r) return nullptr;
+    
+    IRBuilder<>& builder = cg.builder;
+    switch (op) {
+        case '+': return builder.CreateFAdd(l, r, "addtmp");
+        case '-': return builder.CreateFSub(l, r, "subtmp");
+        case '*': return builder.CreateFMul(l, r, "multmp");
+        case '/': return builder.CreateFDiv(l, r, "divtmp");
+        case '<': return builder.CreateUIToFP(builder.CreateFCmpULT(l, r, "cmptmp"),
+                                            Type::getDoubleTy(cg.context), "booltmp");
+        case '>': return builder.CreateUIToFP(builder.CreateFCmpUGT(l, r, "cmptmp"),
+                                            Type::getDoubleTy(cg.context), "booltmp");
+        default: return nullptr;
+    }
+}
+
+Value* AssignmentAST::codegen(CodeGenContext& cg) {
+    Value* val = expr->codegen(cg);
+    if (!val) return nullptr;
+    
+    AllocaInst* alloca = cg.lookupVariable(varName);
+    cg.builder.CreateStore(val, alloca);
+    return val;
+}
+
+Value* PrintAST::codegen(CodeGenContext& cg) {
+    Value* val = expr->codegen(cg);
+    if (!val) return nullptr;
+    
+    // Declare the runtime print hook if it doesn't exist
+    Function* printFunc = cg.module->getFunction("sarcasm_print");
+    if (!printFunc) {
+        Type* bytePtrTy = PointerType::get(Type::getInt8Ty(cg.context), 0);
+        FunctionType* printType = FunctionType::get(
+            Type::getVoidTy(cg.context),
+            {bytePtrTy, bytePtrTy, Type::getDoubleTy(cg.context)},
+            /*isVarArg=*/false);
+        printFunc = Function::Create(printType, Function::ExternalLinkage, "sarcasm_print", cg.module);
+    }
+    
+    // Create sarcastic format string based on print word
+    std::string format;
+    if (printWord == "show") format = "Fine, here's your precious number: %.2f\n";
+    else if (printWord == "display") format = "Displaying for the visually impaired: %.2f\n";
+    else if (printWord == "reveal") format = "The shocking revelation is: %.2f\n";
+    else format = "Output (because you demanded it): %.2f\n";
+    
+    Value* formatStr = cg.builder.CreateGlobalStringPtr(format);
+    
+    return cg.builder.CreateCall(printFunc, {cg.runtime, formatStr, val});
+}
+
+Value* IfAST::codegen(CodeGenContext& cg) {
+    Value* condVal = condition->codegen(cg);
+    if (!condVal) return nullptr;
+    
+    IRBuilder<>& builder = cg.builder;
+    condVal = builder.CreateFCmpONE(condVal, ConstantFP::get(cg.context, APFloat(0.0)), "obviouslycond");
+    
+    Function* function = builder.GetInsertBlock()->getParent();
+    BasicBlock* thenBB = BasicBlock::Create(cg.context, "obviously_then", function);
+    BasicBlock* mergeBB = BasicBlock::Create(cg.context, "obviously_cont", function);
+    
+    builder.CreateCondBr(condVal, thenBB, mergeBB);
+    
+    builder.SetInsertPoint(thenBB);
+    Value* thenVal = nullptr;
+    for (auto& stmt : thenStmts) {
+        thenVal = stmt->codegen(cg);
+    }
+    builder.CreateBr(mergeBB);
+    
+    builder.SetInsertPoint(mergeBB);
+    
+    return Constant::getNullValue(Type::getDoubleTy(cg.context));
+}
+
+Value* WhileAST::codegen(CodeGenContext& cg) {
+    IRBuilder<>& builder = cg.builder;
+    Function* function = builder.GetInsertBlock()->getParent();
+    BasicBlock* loopBB = BasicBlock::Create(cg.context, "whatever_loop", function);
+    BasicBlock* bodyBB = BasicBlock::Create(cg.context, "whatever_body", function);
+    BasicBlock* afterBB = BasicBlock::Create(cg.context, "whatever_after", function);
+    
+    builder.CreateBr(loopBB);
+    builder.SetInsertPoint(loopBB);
+    
+    Value* condVal = condition->codegen(cg);
+    if (!condVal) return nullptr;
+    
+    condVal = builder.CreateFCmpONE(condVal, ConstantFP::get(cg.context, APFloat(0.0)), "whatevercond");
+    builder.CreateCondBr(condVal, bodyBB, afterBB);
+    
+    builder.SetInsertPoint(bodyBB);
+    for (auto& stmt : body) {
+        stmt->codegen(cg);
+    }
+    
+    if (cg.yieldAtBackEdges) {
+        // Burn one unit of fuel per iteration and hand the worker back to the
+        // scheduler when it runs out. Every variable is stored back to its
+        // slot on the way out, so resuming at the loop header is enough.
+        ConstantInt* resumePoint = ConstantInt::get(Type::getInt32Ty(cg.context), ++cg.loopCount);
+        cg.dispatch->addCase(resumePoint, loopBB);
+        
+        Type* fuelTy = Type::getInt64Ty(cg.context);
+        Value* fuelPtr = builder.CreateBitCast(cg.runtime, PointerType::get(fuelTy, 0), "fuelptr");
+        Value* fuel = builder.CreateLoad(fuelTy, fuelPtr, "fuel");
+        fuel = builder.CreateSub(fuel, ConstantInt::get(fuelTy, 1), "fuelleft");
+        builder.CreateStore(fuel, fuelPtr);
+        
+        BasicBlock* yieldBB = BasicBlock::Create(cg.context, "whatever_yield", function);
+        Value* exhausted = builder.CreateICmpSLE(fuel, ConstantInt::get(fuelTy, 0), "exhausted");
+        builder.CreateCondBr(exhausted, yieldBB, loopBB);
+        
+        builder.SetInsertPoint(yieldBB);
+        builder.CreateBr(cg.exitBlock);
+        cg.exitCode->addIncoming(resumePoint, yieldBB);
+    } else {
+        builder.CreateBr(loopBB);
+    }
+    
+    builder.SetInsertPoint(afterBB);
+    
+    return Constant::getNullValue(Type::getDoubleTy(cg.context));
+}
+
+Value* SarcasmLineAST::codegen(CodeGenContext& cg) {
+    // Add sarcastic comment to LLVM IR
+    Value* result = statement->codegen(cg);
+    
+    // Print the insult as a comment during compilation
+    if (cg.verbose) {
+        std::cout << "  ; Line " << cg.lineNum << ": " << insult
+                  << " says something ridiculous" << std::endl;
+    }
+    cg.lineNum++;
+    
+    return result;
+}
+
+// SarcasmLang Parser
+class SarcasmParser {
+private:
+    SarcasmLexer lexer;
+    Token currentToken;
+    std::ostream& diagnostics;
+    bool hadError = false;
+    
+    void nextToken() {
+        currentToken = lexer.nextToken();
+    }
+    
+public:
+    SarcasmParser(const std::string& input, std::ostream& diagnostics = std::cerr, size_t firstLine = 1)
+        : lexer(input, diagnostics, firstLine), diagnostics(diagnostics) {
+        nextToken();
+    }
+    
+    // True if parseProgram() stopped before the end of the input
+    bool failed() const {
+        return hadError || lexer.truncated();
+    }
+    
+    std::unique_ptr<ASTNode> parseExpression();
+    std::unique_ptr<ASTNode> parseTerm();
+    std::unique_ptr<ASTNode> parseFactor();
+    std::unique_ptr<ASTNode> parseStatement();
+    std::unique_ptr<ASTNode> parseLine();
+    std::vector<std::unique_ptr<ASTNode>> parseProgram();
+};
+
+std::unique_ptr<ASTNode> SarcasmParser::parseFactor() {
+    if (currentToken.type == TOKEN_NUMBER) {
+        double val = currentToken.numValue;
+        nextToken();
+        return std::make_unique<NumberExprAST>(val);
+    }
+    
+    if (currentToken.type == TOKEN_IDENTIFIER) {
+        std::string name = currentToken.value;
+        nextToken();
+        return std::make_unique<VariableExprAST>(name);
+    }
+    
+    if (currentToken.type == TOKEN_LPAREN) {
+        nextToken();
+        auto expr = parseExpression();
+        if (!expr) return nullptr;
+        if (currentToken.type != TOKEN_RPAREN) {
+            diagnostics << "genius: Expected ')' but you forgot it, obviously" << std::endl;
+            return nullptr;
+        }
+        nextToken();
+        return expr;
+    }
+    
+    diagnostics << "pea_brain: Expected a number, a variable or '(' and got "
+                << (currentToken.value.empty() ? "nothing" : "'" + currentToken.value + "'")
+                << " instead" << std::endl;
+    return nullptr;
+}
+
+std::unique_ptr<ASTNode> SarcasmParser::parseTerm() {
+    auto left = parseFactor();
+    if (!left) return nullptr;
+    
+    while (currentToken.type == TOKEN_MULTIPLY || currentToken.type == TOKEN_DIVIDE ||
+           currentToken.type == TOKEN_WORD_MULTIPLY || currentToken.type == TOKEN_WORD_DIVIDE) {
+        char op;
+        if (currentToken.type == TOKEN_MULTIPLY || currentToken.type == TOKEN_WORD_MULTIPLY) {
+            op = '*';
+        } else {
+            op = '/';
+        }
+        nextToken();
+        auto right = parseFactor();
+        if (!right) return nullptr;
+        left = std::make_unique<BinaryExprAST>(op, std::move(left), std::move(right));
+    }
+    
+    return left;
+}
+
+std::unique_ptr<ASTNode> SarcasmParser::parseExpression() {
+    auto left = parseTerm();
+    if (!left) return nullptr;
+    
+    while (currentToken.type == TOKEN_PLUS || currentToken.type == TOKEN_MINUS ||
+           currentToken.type == TOKEN_WORD_PLUS || currentToken.type == TOKEN_WORD_MINUS ||
+           currentToken.type == TOKEN_LESS || currentToken.type == TOKEN_GREATER) {
+        char op;
+        if (currentToken.type == TOKEN_PLUS || currentToken.type == TOKEN_WORD_PLUS) op = '+';
+        else if (currentToken.type == TOKEN_MINUS || currentToken.type == TOKEN_WORD_MINUS) op = '-';
+        else if (currentToken.type == TOKEN_LESS) op = '<';
+        else op = '>';
+        
+        nextToken();
+        auto right = parseTerm();
+        if (!right) return nullptr;
+        left = std::make_unique<BinaryExprAST>(op, std::move(left), std::move(right));
+    }
+    
+    return left;
+}
+
+std::unique_ptr<ASTNode> SarcasmParser::parseStatement() {
+    if (currentToken.type == TOKEN_IDENTIFIER) {
+        std::string varName = currentToken.value;
+        nextToken();
+        if (currentToken.type == TOKEN_ASSIGN) {
+            nextToken();
+            auto expr = parseExpression();
+            if (!expr) return nullptr;
+            return std::make_unique<AssignmentAST>(varName, std::move(expr));
+        }
+    }
+    
+    if (currentToken.type == TOKEN_SHOW) {
+        std::string printWord = currentToken.value;
+        nextToken();
+        auto expr = parseExpression();
+        if (!expr) return nullptr;
+        return std::make_unique<PrintAST>(std::move(expr), printWord);
+    }
+    
+    if (currentToken.type == TOKEN_OBVIOUSLY) {
+        nextToken();
+        auto condition = parseExpression();
+        if (!condition) return nullptr;
+        if (currentToken.type != TOKEN_THEN) {
+            diagnostics << "smartass: Expected 'then' after condition, duh!" << std::endl;
+            return nullptr;
+        }
+        nextToken();
+        if (currentToken.type != TOKEN_LBRACE) {
+            diagnostics << "blockhead: Expected '{' to start obviously block" << std::endl;
+            return nullptr;
+        }
+        nextToken();
+        
+        std::vector<std::unique_ptr<ASTNode>> thenStmts;
+        while (currentToken.type != TOKEN_RBRACE && currentToken.type != TOKEN_EOF) {
+            auto line = parseLine();
+            if (!line) return nullptr;
+            thenStmts.push_back(std::move(line));
+        }
+        
+        if (currentToken.type != TOKEN_RBRACE) {
+            diagnostics << "bonehead: Expected '}' to end obviously block" << std::endl;
+            return nullptr;
+        }
+        nextToken();
+        
+        return std::make_unique<IfAST>(std::move(condition), std::move(thenStmts));
+    }
+    
+    if (currentToken.type == TOKEN_WHATEVER) {
+        nextToken();
+        auto condition = parseExpression();
+        if (!condition) return nullptr;
+        if (currentToken.type != TOKEN_DO) {
+            diagnostics << "dimwit: Expected 'do' after whatever condition" << std::endl;
+            return nullptr;
+        }
+        nextToken();
+        if (currentToken.type != TOKEN_LBRACE) {
+            diagnostics << "numbskull: Expected '{' to start whatever block" << std::endl;
+            return nullptr;
+        }
+        nextToken();
+        
+        std::vector<std::unique_ptr<ASTNode>> body;
+        while (currentToken.type != TOKEN_RBRACE && currentToken.type != TOKEN_EOF) {
+            auto line = parseLine();
+            if (!line) return nullptr;
+            body.push_back(std::move(line));
+        }
+        
+        if (currentToken.type != TOKEN_RBRACE) {
+            diagnostics << "meathead: Expected '}' to end whatever block" << std::endl;
+            return nullptr;
+        }
+        nextToken();
+        
+        return std::make_unique<WhileAST>(std::move(condition), std::move(body));
+    }
+    
+    return nullptr;
+}
+
+std::unique_ptr<ASTNode> SarcasmParser::parseLine() {
+    if (currentToken.type != TOKEN_INSULT) {
+        diagnostics << "amateur: Every line must start with an insult, you casual!" << std::endl;
+        return nullptr;
+    }
+    
+    std::string insult = currentToken.value;
+    nextToken();
+    
+    if (currentToken.type != TOKEN_COLON) {
+        diagnostics << "rookie: Expected ':' after insult '" << insult << "'" << std::endl;
+        return nullptr;
+    }
+    nextToken();
+    
+    auto statement = parseStatement();
+    if (!statement) {
+        diagnostics << "noob: Failed to parse statement after '" << insult << ":'" << std::endl;
+        return nullptr;
+    }
+    
+    return std::make_unique<SarcasmLineAST>(insult, std::move(statement));
+}
+
+std::vector<std::unique_ptr<ASTNode>> SarcasmParser::parseProgram() {
+    std::vector<std::unique_ptr<ASTNode>> lines;
+    
+    while (currentToken.type != TOKEN_EOF) {
+        auto line = parseLine();
+        if (line) {
+            lines.push_back(std::move(line));
+        } else {
+            diagnostics << "scrub: Parse error encountered" << std::endl;
+            hadError = true;
+            break;
+        }
+    }
+    
+    return lines;
+}
+
+// Offsets just past every newline that sits outside all `{ ... }` blocks.
+// Only braces span lines, so the source can only be cut at these points.
+// With SSE2 the scan checks 16 bytes at a time and only looks closer at the
+// rare blocks that contain a brace or newline.
+static std::vector<size_t> findTopLevelLineBreaks(const std::string& source) {
+    std::vector<size_t> breaks;
+    const char* text = source.data();
+    size_t size = source.size();
+    long depth = 0;
+    
+    auto visit = [&](size_t pos) {
+        char c = text[pos];
+        if (c == '{') depth++;
+        else if (c == '}') depth--;
+        else if (c == '\n' && depth <= 0) breaks.push_back(pos + 1);
+    };
+    
+    size_t pos = 0;
+#if defined(__SSE2__)
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; pos + 16 <= size; pos += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + pos));
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, open), _mm_cmpeq_epi8(block, close)),
+                                    _mm_cmpeq_epi8(block, newline));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+        while (mask) {
+            visit(pos + static_cast<size_t>(__builtin_ctz(mask)));
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; pos < size; ++pos) {
+        visit(pos);
+    }
+    return breaks;
+}
+
+// True if a line starting at `pos` opens with `insult:`, which no statement
+// can continue into, so the serial parser would start a fresh line there too
+static bool startsSarcasmLine(const std::string& source, size_t pos) {
+    size_t size = source.size();
+    while (pos < size && std::isspace(static_cast<unsigned char>(source[pos]))) pos++;
+    std::string word;
+    while (pos < size && (std::isalnum(static_cast<unsigned char>(source[pos])) || source[pos] == '_')) {
+        word += static_cast<char>(std::tolower(static_cast<unsigned char>(source[pos++])));
+    }
+    while (pos < size && std::isspace(static_cast<unsigned char>(source[pos]))) pos++;
+    return pos < size && source[pos] == ':' && insults.count(word);
+}
+
+// Parses a whole program. Large sources are cut at top-level line boundaries
+// into one piece per thread and the pieces are lexed and parsed in parallel.
+// Diagnostics are replayed in source order and everything after the first
+// piece that fails is dropped, so the result matches a serial parse.
+// Returns false unless the whole source parsed.
+static bool parseSource(const std::string& source, unsigned threads,
+                        std::vector<std::unique_ptr<ASTNode>>& program) {
+    const size_t minPieceBytes = 64 * 1024;
+    size_t pieceCount = std::min<size_t>(std::max(threads, 1u), source.size() / minPieceBytes);
+    if (pieceCount <= 1) {
+        SarcasmParser parser(source);
+        program = parser.parseProgram();
+        return !parser.failed();
+    }
+    
+    std::vector<size_t> breaks = findTopLevelLineBreaks(source);
+    std::vector<size_t> cuts = {0};
+    auto next = breaks.begin();
+    for (size_t k = 1; k < pieceCount; ++k) {
+        next = std::lower_bound(next, breaks.end(), source.size() * k / pieceCount);
+        while (next != breaks.end() && !startsSarcasmLine(source, *next)) ++next;
+        if (next == breaks.end()) break;
+        if (*next > cuts.back()) cuts.push_back(*next);
+    }
+    cuts.push_back(source.size());
+    
+    struct Piece {
+        std::vector<std::unique_ptr<ASTNode>> lines;
+        std::ostringstream diagnostics;
+        bool failed = false;
+    };
+    std::vector<Piece> pieces(cuts.size() - 1);
+    auto parsePiece = [&](size_t k) {
+        size_t firstLine = 1 + std::count(source.begin(), source.begin() + cuts[k], '\n');
+        SarcasmParser parser(source.substr(cuts[k], cuts[k + 1] - cuts[k]), pieces[k].diagnostics, firstLine);
+        pieces[k].lines = parser.parseProgram();
+        pieces[k].failed = parser.failed();
+    };
+    
+    std::vector<std::thread> workers;
+    for (size_t k = 1; k < pieces.size(); ++k) {
+        workers.emplace_back(parsePiece, k);
+    }
+    parsePiece(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    
+    for (Piece& piece : pieces) {
+        std::cerr << piece.diagnostics.str();
+        std::move(piece.lines.begin(), piece.lines.end(), std::back_inserter(program));
+        if (piece.failed) return false;
+    }
+    return true;
+}
+
+CompiledProgram::CompiledProgram() = default;
+CompiledProgram::~CompiledProgram() = default;
+
+static void initializeNativeTargetOnce() {
+    static std::once_flag initialized;
+    std::call_once(initialized, [] {
+        InitializeNativeTarget();
+        InitializeNativeTargetAsmPrinter();
+        InitializeNativeTargetAsmParser();
+    });
+}
+
+typedef std::vector<std::unique_ptr<ASTNode>>::iterator LineIterator;
+
+static FunctionType* entryFunctionType(LLVMContext& context) {
+    Type* int32Ty = Type::getInt32Ty(context);
+    Type* slotsTy = PointerType::get(Type::getDoublePtrTy(context), 0);
+    Type* runtimeTy = PointerType::get(Type::getInt8Ty(context), 0);
+    return FunctionType::get(int32Ty, {slotsTy, runtimeTy, int32Ty}, false);
+}
+
+// Emits `i32 name(double** slots, i8* runtime, i32 resume)` running [begin, end):
+//   entry:    allocas, then every variable loaded from its slot
+//   dispatch: switch on `resume` to the start or to a yielded loop header
+//   exit:     every variable stored back to its slot, return the exit code
+static Function* emitResumable(CodeGenContext& cg, const std::string& name, LineIterator begin, LineIterator end) {
+    LLVMContext& context = cg.context;
+    Type* int32Ty = Type::getInt32Ty(context);
+    
+    Function* func = Function::Create(entryFunctionType(context), Function::ExternalLinkage, name, cg.module);
+    auto argIt = func->arg_begin();
+    cg.slots = &*argIt++;
+    cg.slots->setName("slots");
+    cg.runtime = &*argIt++;
+    cg.runtime->setName("runtime");
+    Value* resume = &*argIt;
+    resume->setName("resume");
+    cg.function = func;
+    cg.namedValues.clear();
+    
+    BasicBlock* entryBB = BasicBlock::Create(context, "entry", func);
+    BasicBlock* dispatchBB = BasicBlock::Create(context, "dispatch", func);
+    BasicBlock* startBB = BasicBlock::Create(context, "start", func);
+    cg.exitBlock = BasicBlock::Create(context, "exit", func);
+    
+    IRBuilder<>& builder = cg.builder;
+    builder.SetInsertPoint(entryBB);
+    builder.CreateBr(dispatchBB);
+    builder.SetInsertPoint(dispatchBB);
+    cg.dispatch = builder.CreateSwitch(resume, startBB);
+    builder.SetInsertPoint(cg.exitBlock);
+    cg.exitCode = builder.CreatePHI(int32Ty, 2, "exitcode");
+    
+    builder.SetInsertPoint(startBB);
+    for (LineIterator line = begin; line != end; ++line) {
+        (*line)->codegen(cg);
+    }
+    builder.CreateBr(cg.exitBlock);
+    cg.exitCode->addIncoming(ConstantInt::get(int32Ty, 0), builder.GetInsertBlock());
+    
+    // Now that every variable is known, wire them up to the host slots
+    cg.exitBlock->moveAfter(&func->back());
+    IRBuilder<> copyIn(entryBB->getTerminator());
+    builder.SetInsertPoint(cg.exitBlock);
+    Type* doubleTy = Type::getDoubleTy(context);
+    for (auto& variable : cg.namedValues) {
+        const std::string& varName = variable.first;
+        copyIn.CreateStore(copyIn.CreateLoad(doubleTy, cg.slotPointer(copyIn, varName)), variable.second);
+        builder.CreateStore(builder.CreateLoad(doubleTy, variable.second), cg.slotPointer(builder, varName));
+    }
+    builder.CreateRet(cg.exitCode);
+    
+    return func;
+}
+
+// Emits `sarcasm_main` for a program. With more than one chunk, the top-level
+// lines are spread over `sarcasm_chunk_N` functions of the same shape so the
+// backend has independent pieces to compile in parallel, and `sarcasm_main`
+// just calls them in order. Resume points are numbered across the whole
+// program, so a yielded run skips the chunks before the one that yielded.
+static Function* emitProgram(CodeGenContext& cg, std::vector<std::unique_ptr<ASTNode>>& program, unsigned chunks) {
+    size_t chunkCount = std::min<size_t>(std::max(chunks, 1u), program.size());
+    if (chunkCount <= 1) {
+        return emitResumable(cg, "sarcasm_main", program.begin(), program.end());
+    }
+    
+    struct Chunk {
+        Function* func;
+        int firstResume;    // Resume points in (firstResume, lastResume]
+        int lastResume;
+    };
+    std::vector<Chunk> chunkFuncs;
+    size_t linesPerChunk = (program.size() + chunkCount - 1) / chunkCount;
+    for (size_t first = 0; first < program.size(); first += linesPerChunk) {
+        size_t last = std::min(first + linesPerChunk, program.size());
+        int firstResume = cg.loopCount;
+        Function* func = emitResumable(cg, "sarcasm_chunk_" + std::to_string(chunkFuncs.size()),
+                                       program.begin() + first, program.begin() + last);
+        // Keep the optimizer from gluing the chunks back together
+        func->addFnAttr(Attribute::NoInline);
+        chunkFuncs.push_back({func, firstResume, cg.loopCount});
+    }
+    
+    LLVMContext& context = cg.context;
+    Type* int32Ty = Type::getInt32Ty(context);
+    Function* mainFunc = Function::Create(entryFunctionType(context), Function::ExternalLinkage, "sarcasm_main", cg.module);
+    auto argIt = mainFunc->arg_begin();
+    Value* slots = &*argIt++;
+    slots->setName("slots");
+    Value* runtime = &*argIt++;
+    runtime->setName("runtime");
+    Value* resume = &*argIt;
+    resume->setName("resume");
+    
+    IRBuilder<>& builder = cg.builder;
+    BasicBlock* nextBB = BasicBlock::Create(context, "entry", mainFunc);
+    BasicBlock* yieldBB = BasicBlock::Create(context, "yielded", mainFunc);
+    builder.SetInsertPoint(yieldBB);
+    PHINode* yieldCode = builder.CreatePHI(int32Ty, chunkFuncs.size(), "exitcode");
+    builder.CreateRet(yieldCode);
+    
+    for (size_t k = 0; k < chunkFuncs.size(); ++k) {
+        const Chunk& chunk = chunkFuncs[k];
+        BasicBlock* checkBB = nextBB;
+        BasicBlock* callBB = BasicBlock::Create(context, "call_chunk_" + std::to_string(k), mainFunc, yieldBB);
+        nextBB = BasicBlock::Create(context, "after_chunk_" + std::to_string(k), mainFunc, yieldBB);
+        
+        // Chunks that finished before the yield point don't run again
+        builder.SetInsertPoint(checkBB);
+        Value* alreadyRan = builder.CreateICmpUGT(resume, ConstantInt::get(int32Ty, chunk.lastResume), "alreadyran");
+        builder.CreateCondBr(alreadyRan, nextBB, callBB);
+        
+        builder.SetInsertPoint(callBB);
+        Value* ownsResume = builder.CreateICmpUGT(resume, ConstantInt::get(int32Ty, chunk.firstResume), "ownsresume");
+        Value* chunkResume = builder.CreateSelect(ownsResume, resume, ConstantInt::get(int32Ty, 0), "chunkresume");
+        Value* code = builder.CreateCall(chunk.func, {slots, runtime, chunkResume}, "chunkcode");
+        builder.CreateCondBr(builder.CreateICmpNE(code, ConstantInt::get(int32Ty, 0), "chunkyielded"), yieldBB, nextBB);
+        yieldCode->addIncoming(code, callBB);
+    }
+    
+    builder.SetInsertPoint(nextBB);
+    builder.CreateRet(ConstantInt::get(int32Ty, 0));
+    
+    return mainFunc;
+}
+
+// Backend side of a numeric profile: contract lets it fuse multiplies and
+// adds into FMAs, fast additionally drops IEEE corner cases
+static TargetOptions targetOptionsFor(NumericProfile profile) {
+    TargetOptions targetOptions;
+    if (profile != NUMERIC_STRICT) {
+        targetOptions.AllowFPOpFusion = FPOpFusion::Fast;
+    }
+    if (profile == NUMERIC_FAST) {
+        targetOptions.UnsafeFPMath = true;
+        targetOptions.NoInfsFPMath = true;
+        targetOptions.NoNaNsFPMath = true;
+        targetOptions.NoSignedZerosFPMath = true;
+        targetOptions.ApproxFuncFPMath = true;
+    }
+    return targetOptions;
+}
+
+// Codegen reads the relaxed-math switches from function attributes, so
+// mirror the fast profile there too
+static void setNumericAttributes(Module& module, NumericProfile profile) {
+    if (profile != NUMERIC_FAST) return;
+    for (Function& func : module) {
+        if (func.isDeclaration()) continue;
+        func.addFnAttr("unsafe-fp-math", "true");
+        func.addFnAttr("no-infs-fp-math", "true");
+        func.addFnAttr("no-nans-fp-math", "true");
+        func.addFnAttr("no-signed-zeros-fp-math", "true");
+        func.addFnAttr("approx-func-fp-math", "true");
+    }
+}
+
+// A CPU to generate code for. For the host the features come from CPUID
+// rather than the model name, so a VM that hides AVX-512 doesn't get it.
+struct CpuTarget {
+    std::string name;
+    std::vector<std::string> features;
+    
+    std::string featureString() const {
+        return join(features, ",");
+    }
+};
+
+static CpuTarget selectCpu(const CompileOptions& options, bool forHost) {
+    CpuTarget cpu;
+    if (options.cpu == "host" || (options.cpu.empty() && forHost)) {
+        cpu.name = sys::getHostCPUName().str();
+        StringMap<bool> features;
+        if (sys::getHostCPUFeatures(features)) {
+            for (auto& feature : features) {
+                cpu.features.push_back((feature.second ? "+" : "-") + feature.first().str());
+            }
+        }
+    } else {
+        cpu.name = options.cpu.empty() ? "generic" : options.cpu;
+    }
+    return cpu;
+}
+
+// x86-64 clones made of every hot function in a multiversioned object, best
+// first. `requiredFeatures` are bits of libgcc's __cpu_model.__cpu_features[0]
+// (the word __builtin_cpu_supports tests), all of which must be set.
+struct CpuVariant {
+    const char* suffix;
+    const char* cpu;
+    uint32_t requiredFeatures;
+};
+
+static const CpuVariant x86Variants[] = {
+    // AVX512F, AVX512VL, AVX512BW, AVX512DQ, AVX512CD
+    {"avx512", "skylake-avx512", (1u << 15) | (1u << 20) | (1u << 21) | (1u << 22) | (1u << 23)},
+    // AVX2, FMA, BMI2
+    {"avx2", "haswell", (1u << 10) | (1u << 14) | (1u << 17)},
+};
+
+// Turns every function containing a loop into a dispatcher over clones
+// compiled for the CPUs above. The first call asks libgcc what the machine
+// supports and caches the best clone in a function pointer, so later calls
+// cost a load and an indirect call. This is what clang's target_clones does
+// with an ifunc, minus the dependency on ELF and the dynamic loader.
+static void multiversionHotFunctions(Module& module) {
+    LLVMContext& context = module.getContext();
+    Type* int32Ty = Type::getInt32Ty(context);
+    StructType* cpuModelTy = StructType::get(context, {int32Ty, int32Ty, int32Ty, ArrayType::get(int32Ty, 1)});
+    Constant* cpuModel = module.getOrInsertGlobal("__cpu_model", cpuModelTy);
+    FunctionCallee cpuInit = module.getOrInsertFunction("__cpu_indicator_init", FunctionType::get(int32Ty, false));
+    
+    std::vector<Function*> hot;
+    for (Function& func : module) {
+        if (func.isDeclaration()) continue;
+        SmallVector<std::pair<const BasicBlock*, const BasicBlock*>, 8> backEdges;
+        FindFunctionBackedges(func, backEdges);
+        if (!backEdges.empty()) {
+            hot.push_back(&func);
+        }
+    }
+    
+    for (Function* func : hot) {
+        std::string name = func->getName().str();
+        Function* dispatcher = Function::Create(func->getFunctionType(), func->getLinkage(), "", &module);
+        dispatcher->takeName(func);
+        dispatcher->setAttributes(func->getAttributes());
+        func->replaceAllUsesWith(dispatcher);
+        func->setName(name + ".default");
+        func->setLinkage(GlobalValue::InternalLinkage);
+        
+        // Worst to best, so the best supported clone wins the select chain
+        std::vector<std::pair<Function*, uint32_t>> clones;
+        for (auto variant = std::rbegin(x86Variants); variant != std::rend(x86Variants); ++variant) {
+            ValueToValueMapTy valueMap;
+            Function* clone = CloneFunction(func, valueMap);
+            clone->setName(name + "." + variant->suffix);
+            clone->addFnAttr("target-cpu", variant->cpu);
+            clone->addFnAttr("target-features", "");
+            clones.push_back({clone, variant->requiredFeatures});
+        }
+        
+        PointerType* funcPtrTy = func->getType();
+        auto* resolved = new GlobalVariable(module, funcPtrTy, false, GlobalValue::InternalLinkage,
+                                            ConstantPointerNull::get(funcPtrTy), name + ".resolved");
+        
+        BasicBlock* entryBB = BasicBlock::Create(context, "entry", dispatcher);
+        BasicBlock* resolveBB = BasicBlock::Create(context, "resolve", dispatcher);
+        BasicBlock* callBB = BasicBlock::Create(context, "call", dispatcher);
+        IRBuilder<> builder(entryBB);
+        LoadInst* cached = builder.CreateLoad(funcPtrTy, resolved, "cached");
+        cached->setAtomic(AtomicOrdering::Monotonic);
+        builder.CreateCondBr(builder.CreateIsNull(cached), resolveBB, callBB);
+        
+        builder.SetInsertPoint(resolveBB);
+        builder.CreateCall(cpuInit);
+        Value* featuresPtr = builder.CreateInBoundsGEP(cpuModelTy, cpuModel,
+                                                       {builder.getInt32(0), builder.getInt32(3), builder.getInt32(0)});
+        Value* features = builder.CreateLoad(int32Ty, featuresPtr, "cpufeatures");
+        Value* choice = func;
+        for (auto& clone : clones) {
+            Value* required = builder.getInt32(clone.second);
+            Value* supported = builder.CreateICmpEQ(builder.CreateAnd(features, required), required, "supported");
+            choice = builder.CreateSelect(supported, clone.first, choice, "choice");
+        }
+        builder.CreateStore(choice, resolved)->setAtomic(AtomicOrdering::Monotonic);
+        builder.CreateBr(callBB);
+        
+        builder.SetInsertPoint(callBB);
+        PHINode* target = builder.CreatePHI(funcPtrTy, 2, "target");
+        target->addIncoming(cached, entryBB);
+        target->addIncoming(choice, resolveBB);
+        std::vector<Value*> args;
+        for (Argument& arg : dispatcher->args()) {
+            args.push_back(&arg);
+        }
+        CallInst* call = builder.CreateCall(func->getFunctionType(), target, args);
+        call->setTailCall();
+        if (call->getType()->isVoidTy()) {
+            builder.CreateRetVoid();
+        } else {
+            builder.CreateRet(call);
+        }
+    }
+}
+
+// Standard O3 pipeline, tuned for the machine the code will run on
+static void optimizeModule(Module& module, TargetMachine* targetMachine) {
+    LoopAnalysisManager loopAM;
+    FunctionAnalysisManager functionAM;
+    CGSCCAnalysisManager cgsccAM;
+    ModuleAnalysisManager moduleAM;
+    
+    PassBuilder passBuilder(targetMachine);
+    passBuilder.registerModuleAnalyses(moduleAM);
+    passBuilder.registerCGSCCAnalyses(cgsccAM);
+    passBuilder.registerFunctionAnalyses(functionAM);
+    passBuilder.registerLoopAnalyses(loopAM);
+    passBuilder.crossRegisterProxies(loopAM, functionAM, cgsccAM, moduleAM);
+    
+    ModulePassManager passes = passBuilder.buildPerModuleDefaultPipeline(OptimizationLevel::O3);
+    passes.run(module, moduleAM);
+}
+
+// Splits the module into `partitions` pieces and runs instruction selection
+// and register allocation for each piece on its own thread (LLVM's
+// splitCodeGen: SplitModule, then one fresh context per partition).
+// Returns one relocatable object per piece.
+static std::vector<std::unique_ptr<MemoryBuffer>> emitObjectsInParallel(
+    Module& module, unsigned partitions,
+    const std::function<std::unique_ptr<TargetMachine>()>& makeTargetMachine) {
+    std::vector<SmallString<0>> objects(partitions);
+    std::vector<std::unique_ptr<raw_svector_ostream>> streams;
+    std::vector<raw_pwrite_stream*> outputs;
+    for (SmallString<0>& object : objects) {
+        streams.push_back(std::make_unique<raw_svector_ostream>(object));
+        outputs.push_back(streams.back().get());
+    }
+    
+    splitCodeGen(module, outputs, {}, makeTargetMachine);
+    
+    std::vector<std::unique_ptr<MemoryBuffer>> buffers;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        buffers.push_back(MemoryBuffer::getMemBufferCopy(objects[i].str(),
+                                                         "sarcasm-part-" + std::to_string(i) + ".o"));
+    }
+    return buffers;
+}
+
+// Hands the module over to MCJIT, optionally running the optimizer on it first.
+// With more than one codegen thread the module is compiled to objects up
+// front and MCJIT just links them, hanging off an empty placeholder module.
+static bool createEngine(CompiledProgram& compiled, std::unique_ptr<Module> module,
+                         const CompileOptions& options) {
+    bool parallel = options.codegenThreads > 1;
+    TargetOptions targetOptions = targetOptionsFor(options.numericProfile);
+    Module* rawModule = module.get();
+    std::string errStr;
+    EngineBuilder engineBuilder(parallel ? std::make_unique<Module>("SarcasmLang.objects", module->getContext())
+                                         : std::move(module));
+    engineBuilder.setErrorStr(&errStr);
+    engineBuilder.setTargetOptions(targetOptions);
+    CpuTarget cpu = selectCpu(options, /*forHost=*/true);
+    engineBuilder.setMCPU(cpu.name);
+    engineBuilder.setMAttrs(cpu.features);
+    
+    TargetMachine* targetMachine = engineBuilder.selectTarget();
+    if (!targetMachine) {
+        std::cerr << "genius: Failed to create execution engine: " << errStr << std::endl;
+        return false;
+    }
+    rawModule->setDataLayout(targetMachine->createDataLayout());
+    rawModule->setTargetTriple(targetMachine->getTargetTriple().str());
+    setNumericAttributes(*rawModule, options.numericProfile);
+    if (options.optimize) {
+        optimizeModule(*rawModule, targetMachine);
+    }
+    
+    std::vector<std::unique_ptr<MemoryBuffer>> objects;
+    if (parallel) {
+        objects = emitObjectsInParallel(*rawModule, options.codegenThreads, [targetOptions, cpu] {
+            return std::unique_ptr<TargetMachine>(EngineBuilder()
+                                                      .setTargetOptions(targetOptions)
+                                                      .setMCPU(cpu.name)
+                                                      .setMAttrs(cpu.features)
+                                                      .selectTarget());
+        });
+    }
+    
+    compiled.engine.reset(engineBuilder.create(targetMachine));
+    if (!compiled.engine) {
+        std::cerr << "genius: Failed to create execution engine: " << errStr << std::endl;
+        return false;
+    }
+    
+    std::string printName;
+    raw_string_ostream printNameStream(printName);
+    Mangler::getNameWithPrefix(printNameStream, "sarcasm_print", compiled.engine->getDataLayout());
+    compiled.engine->addGlobalMapping(printNameStream.str(), reinterpret_cast<uint64_t>(&sarcasm_print));
+    
+    for (auto& buffer : objects) {
+        auto object = object::ObjectFile::createObjectFile(buffer->getMemBufferRef());
+        if (!object) {
+            std::cerr << "genius: The backend produced garbage: " << toString(object.takeError()) << std::endl;
+            return false;
+        }
+        compiled.engine->addObjectFile(object::OwningBinary<object::ObjectFile>(std::move(*object), std::move(buffer)));
+    }
+    return true;
+}
+
+// A few chunks per thread, so uneven lines still balance across partitions
+static unsigned codegenChunks(const CompileOptions& options) {
+    return options.codegenThreads > 1 ? options.codegenThreads * 4 : 1;
+}
+
+std::unique_ptr<CompiledProgram> compileProgram(const std::string& source, const CompileOptions& options) {
+    initializeNativeTargetOnce();
+    
+    auto compiled = std::make_unique<CompiledProgram>();
+    compiled->context = std::make_unique<LLVMContext>();
+    auto module = std::make_unique<Module>("SarcasmLang", *compiled->context);
+    
+    std::vector<std::unique_ptr<ASTNode>> program;
+    if (!parseSource(source, options.frontendThreads, program)) {
+        return nullptr;
+    }
+    
+    CodeGenContext cg(*compiled->context, module.get());
+    cg.verbose = options.verbose;
+    cg.yieldAtBackEdges = options.yieldAtBackEdges;
+    cg.setNumericProfile(options.numericProfile);
+    
+    if (options.verbose) {
+        std::cout << "\n🎭 SarcasmLang Compilation Comments:" << std::endl;
+    }
+    emitProgram(cg, program, codegenChunks(options));
+    
+    if (verifyModule(*module, &errs())) {
+        std::cerr << "smarty: Function verification failed, congratulations!" << std::endl;
+        return nullptr;
+    }
+    
+    if (options.verbose) {
+        std::cout << "\n📝 Generated LLVM IR:" << std::endl;
+        module->print(outs(), nullptr);
+    }
+    
+    if (!createEngine(*compiled, std::move(module), options)) {
+        return nullptr;
+    }
+    
+    compiled->entry = reinterpret_cast<SarcasmEntryFn>(
+        compiled->engine->getFunctionAddress("sarcasm_main"));
+    if (!compiled->entry) {
+        std::cerr << "genius: JIT lost your program somewhere, impressive" << std::endl;
+        return nullptr;
+    }
+    compiled->variables = std::move(cg.variables);
+    
+    return compiled;
+}
+
+// Gives an AOT module everything it would otherwise get from the host: a
+// `sarcasm_print` that goes straight to printf, and a C `main` that zeroes
+// the variables and runs the program once.
+static void emitStandaloneRuntime(CodeGenContext& cg) {
+    LLVMContext& context = cg.context;
+    Type* doubleTy = Type::getDoubleTy(context);
+    Type* doublePtrTy = Type::getDoublePtrTy(context);
+    Type* int32Ty = Type::getInt32Ty(context);
+    Type* bytePtrTy = PointerType::get(Type::getInt8Ty(context), 0);
+    IRBuilder<>& builder = cg.builder;
+    
+    if (Function* printFunc = cg.module->getFunction("sarcasm_print")) {
+        FunctionType* printfType = FunctionType::get(int32Ty, {bytePtrTy}, /*isVarArg=*/true);
+        FunctionCallee printfFunc = cg.module->getOrInsertFunction("printf", printfType);
+        builder.SetInsertPoint(BasicBlock::Create(context, "entry", printFunc));
+        auto argIt = printFunc->arg_begin();
+        ++argIt;
+        Value* format = &*argIt++;
+        Value* value = &*argIt;
+        builder.CreateCall(printfFunc, {format, value});
+        builder.CreateRetVoid();
+    }
+    
+    Function* mainFunc = Function::Create(FunctionType::get(int32Ty, false),
+                                          Function::ExternalLinkage, "main", cg.module);
+    builder.SetInsertPoint(BasicBlock::Create(context, "entry", mainFunc));
+    size_t slotCount = std::max<size_t>(cg.variables.size(), 1);
+    Value* storage = builder.CreateAlloca(doubleTy, builder.getInt32(slotCount), "storage");
+    Value* slots = builder.CreateAlloca(doublePtrTy, builder.getInt32(slotCount), "slots");
+    for (size_t i = 0; i < slotCount; ++i) {
+        Value* slot = builder.CreateConstInBoundsGEP1_64(doubleTy, storage, i);
+        builder.CreateStore(ConstantFP::get(context, APFloat(0.0)), slot);
+        builder.CreateStore(slot, builder.CreateConstInBoundsGEP1_64(doublePtrTy, slots, i));
+    }
+    builder.CreateCall(cg.module->getFunction("sarcasm_main"),
+                       {slots, ConstantPointerNull::get(cast<PointerType>(bytePtrTy)), builder.getInt32(0)});
+    builder.CreateRet(builder.getInt32(0));
+}
+
+bool compileToObject(const std::string& source, const std::string& path, const CompileOptions& options) {
+    initializeNativeTargetOnce();
+    
+    LLVMContext context;
+    auto module = std::make_unique<Module>("SarcasmLang", context);
+    
+    std::vector<std::unique_ptr<ASTNode>> program;
+    if (!parseSource(source, options.frontendThreads, program)) {
+        return false;
+    }
+    
+    CodeGenContext cg(context, module.get());
+    cg.verbose = options.verbose;
+    cg.setNumericProfile(options.numericProfile);
+    emitProgram(cg, program, codegenChunks(options));
+    emitStandaloneRuntime(cg);
+    
+    if (verifyModule(*module, &errs())) {
+        std::cerr << "smarty: Function verification failed, congratulations!" << std::endl;
+        return false;
+    }
+    
+    std::string triple = sys::getProcessTriple();
+    std::string errStr;
+    const Target* target = TargetRegistry::lookupTarget(triple, errStr);
+    if (!target) {
+        std::cerr << "genius: No backend for " << triple << ": " << errStr << std::endl;
+        return false;
+    }
+    // The fallback clone and everything around the dispatchers are built for
+    // the module's CPU, so they must stay runnable on every x86-64
+    bool multiversion = options.multiversion && Triple(triple).getArch() == Triple::x86_64;
+    if (multiversion && !options.cpu.empty() && options.cpu != "generic" && options.cpu != "x86-64") {
+        std::cerr << "smarty: --multiversion builds its own fallback for the oldest x86-64, so --cpu '"
+                  << options.cpu << "' would just make it crash there. Pick one." << std::endl;
+        return false;
+    }
+    TargetOptions targetOptions = targetOptionsFor(options.numericProfile);
+    CpuTarget cpu = selectCpu(options, /*forHost=*/false);
+    std::string features = cpu.featureString();
+    auto makeTargetMachine = [target, triple, targetOptions, cpu, features] {
+        return std::unique_ptr<TargetMachine>(target->createTargetMachine(
+            triple, cpu.name, features, targetOptions, Reloc::PIC_));
+    };
+    
+    std::unique_ptr<TargetMachine> targetMachine = makeTargetMachine();
+    module->setDataLayout(targetMachine->createDataLayout());
+    module->setTargetTriple(triple);
+    if (multiversion) {
+        multiversionHotFunctions(*module);
+    } else if (options.multiversion) {
+        std::cerr << "caveman: Multiversioning only knows x86-64, building for '" << cpu.name
+                  << "' alone" << std::endl;
+    }
+    setNumericAttributes(*module, options.numericProfile);
+    optimizeModule(*module, targetMachine.get());
+    
+    unsigned partitions = std::max(options.codegenThreads, 1u);
+    std::vector<std::unique_ptr<MemoryBuffer>> objects =
+        emitObjectsInParallel(*module, partitions, makeTargetMachine);
+    
+    if (objects.size() == 1) {
+        std::error_code error;
+        raw_fd_ostream out(path, error, sys::fs::OF_None);
+        if (error) {
+            std::cerr << "genius: Can't write '" << path << "': " << error.message() << std::endl;
+            return false;
+        }
+        out << objects[0]->getBuffer();
+        return true;
+    }
+    
+    // Glue the partitions back into a single relocatable object
+    auto linker = sys::findProgramByName("ld");
+    if (!linker) {
+        std::cerr << "caveman: Need 'ld' on the PATH to merge " << objects.size() << " partitions" << std::endl;
+        return false;
+    }
+    std::vector<std::string> partPaths;
+    std::vector<StringRef> args = {*linker, "-r", "-o", path};
+    bool ok = true;
+    for (auto& object : objects) {
+        SmallString<128> partPath;
+        int fd;
+        if (sys::fs::createTemporaryFile("sarcasm-part", "o", fd, partPath)) {
+            ok = false;
+            break;
+        }
+        raw_fd_ostream out(fd, /*shouldClose=*/true);
+        out << object->getBuffer();
+        partPaths.push_back(partPath.str().str());
+    }
+    for (const std::string& partPath : partPaths) {
+        args.push_back(partPath);
+    }
+    if (ok && sys::ExecuteAndWait(*linker, args) != 0) {
+        ok = false;
+    }
+    for (const std::string& partPath : partPaths) {
+        sys::fs::remove(partPath);
+    }
+    if (!ok) {
+        std::cerr << "caveman: Failed to merge the partitions into '" << path << "'" << std::endl;
+    }
+    return ok;
+}
+
+bool compileAndRun(const std::string& source, CompileOptions options) {
+    options.verbose = true;
+    auto compiled = compileProgram(source, options);
+    if (!compiled) return false;
+    
+    std::vector<double> storage(compiled->variables.size(), 0.0);
+    std::vector<double*> slots;
+    for (double& slot : storage) {
+        slots.push_back(&slot);
+    }
+    SarcasmRuntime runtime = {INT64_MAX, nullptr};
+    
+    std::cout << "\n🚀 Executing your 'brilliant' SarcasmLang program:" << std::endl;
+    compiled->entry(slots.data(), &runtime, 0);
+    
+    std::cout << "\n💀 Execution complete. Hope you're satisfied, "
+              << generateRandomInsult() << "!" << std::endl;
+    return true;
+}
+
+// SarcasmScript implementation
+SarcasmScript::SarcasmScript(std::unique_ptr<CompiledProgram> program)
+    : program(std::move(program)), runtime{INT64_MAX, nullptr} {
+    storage.assign(this->program->variables.size(), 0.0);
+    for (double& slot : storage) {
+        slots.push_back(&slot);
+    }
+}
+
+SarcasmScript::~SarcasmScript() = default;
+
+std::unique_ptr<SarcasmScript> SarcasmScript::compile(const std::string& source, const CompileOptions& options) {
+    auto program = compileProgram(source, options);
+    if (!program) return nullptr;
+    return std::unique_ptr<SarcasmScript>(new SarcasmScript(std::move(program)));
+}
+
+int SarcasmScript::slotIndex(const std::string& name) const {
+    const std::vector<std::string>& names = program->variables;
+    auto it = std::find(names.begin(), names.end(), name);
+    return it == names.end() ? -1 : static_cast<int>(it - names.begin());
+}
+
+bool SarcasmScript::bind(const std::string& name, double* location) {
+    int index = slotIndex(name);
+    if (index < 0 || !location) return false;
+    slots[index] = location;
+    return true;
+}
+
+void SarcasmScript::unbind(const std::string& name) {
+    int index = slotIndex(name);
+    if (index >= 0) slots[index] = &storage[index];
+}
+
+double* SarcasmScript::lookup(const std::string& name) {
+    int index = slotIndex(name);
+    return index < 0 ? nullptr : slots[index];
+}
+
+double SarcasmScript::get(const std::string& name) const {
+    int index = slotIndex(name);
+    return index < 0 ? 0.0 : *slots[index];
+}
+
+void SarcasmScript::set(const std::string& name, double value) {
+    int index = slotIndex(name);
+    if (index >= 0) *slots[index] = value;
+}
+
+// Emits `void sarcasm_batch(double** inputs, double** outputs, i8* runtime, i64 rows)`:
+//   entry:     allocas, then the base pointer of every column
+//   rows_loop: row counter, exits once every row is done
+//   row:       inputs loaded from their columns, everything else reset to 0
+//   start:     the program body, then outputs stored to their columns
+static Function* emitBatch(CodeGenContext& cg, std::vector<std::unique_ptr<ASTNode>>& program,
+                           const std::vector<std::string>& inputs,
+                           const std::vector<std::string>& outputs) {
+    LLVMContext& context = cg.context;
+    Type* doubleTy = Type::getDoubleTy(context);
+    Type* columnTy = Type::getDoublePtrTy(context);
+    Type* columnsTy = PointerType::get(columnTy, 0);
+    Type* int64Ty = Type::getInt64Ty(context);
+    
+    FunctionType* batchType = FunctionType::get(
+        Type::getVoidTy(context),
+        {columnsTy, columnsTy, PointerType::get(Type::getInt8Ty(context), 0), int64Ty},
+        false);
+    Function* batchFunc = Function::Create(batchType, Function::ExternalLinkage, "sarcasm_batch", cg.module);
+    auto argIt = batchFunc->arg_begin();
+    Value* inputsArg = &*argIt++;
+    inputsArg->setName("inputs");
+    Value* outputsArg = &*argIt++;
+    outputsArg->setName("outputs");
+    cg.runtime = &*argIt++;
+    cg.runtime->setName("runtime");
+    Value* rows = &*argIt;
+    rows->setName("rows");
+    cg.function = batchFunc;
+    
+    BasicBlock* entryBB = BasicBlock::Create(context, "entry", batchFunc);
+    BasicBlock* loopBB = BasicBlock::Create(context, "rows_loop", batchFunc);
+    BasicBlock* rowBB = BasicBlock::Create(context, "row", batchFunc);
+    BasicBlock* startBB = BasicBlock::Create(context, "start", batchFunc);
+    BasicBlock* doneBB = BasicBlock::Create(context, "rows_done", batchFunc);
+    
+    IRBuilder<>& builder = cg.builder;
+    builder.SetInsertPoint(entryBB);
+    std::map<std::string, Value*> inputColumns;
+    for (size_t k = 0; k < inputs.size(); ++k) {
+        Value* columnAddr = builder.CreateConstInBoundsGEP1_64(columnTy, inputsArg, k);
+        inputColumns[inputs[k]] = builder.CreateLoad(columnTy, columnAddr, inputs[k] + "_in");
+    }
+    std::vector<Value*> outputColumns;
+    for (size_t k = 0; k < outputs.size(); ++k) {
+        Value* columnAddr = builder.CreateConstInBoundsGEP1_64(columnTy, outputsArg, k);
+        outputColumns.push_back(builder.CreateLoad(columnTy, columnAddr, outputs[k] + "_out"));
+    }
+    builder.CreateBr(loopBB);
+    
+    builder.SetInsertPoint(loopBB);
+    PHINode* row = builder.CreatePHI(int64Ty, 2, "rowidx");
+    row->addIncoming(ConstantInt::get(int64Ty, 0), entryBB);
+    builder.CreateCondBr(builder.CreateICmpSLT(row, rows, "morerows"), rowBB, doneBB);
+    
+    builder.SetInsertPoint(rowBB);
+    builder.CreateBr(startBB);
+    
+    builder.SetInsertPoint(startBB);
+    for (const std::string& name : inputs) {
+        cg.lookupVariable(name);
+    }
+    for (const std::string& name : outputs) {
+        cg.lookupVariable(name);
+    }
+    for (auto& line : program) {
+        line->codegen(cg);
+    }
+    for (size_t k = 0; k < outputs.size(); ++k) {
+        Value* cell = builder.CreateInBoundsGEP(doubleTy, outputColumns[k], row);
+        builder.CreateStore(builder.CreateLoad(doubleTy, cg.namedValues[outputs[k]]), cell);
+    }
+    Value* nextRow = builder.CreateAdd(row, ConstantInt::get(int64Ty, 1), "nextrow", true, true);
+    row->addIncoming(nextRow, builder.GetInsertBlock());
+    builder.CreateBr(loopBB);
+    
+    // Every row starts from its inputs and zeros, like a fresh program would
+    IRBuilder<> rowStart(rowBB->getTerminator());
+    for (auto& variable : cg.namedValues) {
+        const std::string& name = variable.first;
+        Value* initial = ConstantFP::get(context, APFloat(0.0));
+        auto input = inputColumns.find(name);
+        if (input != inputColumns.end()) {
+            Value* cell = rowStart.CreateInBoundsGEP(doubleTy, input->second, row);
+            initial = rowStart.CreateLoad(doubleTy, cell, name + "_cell");
+        }
+        rowStart.CreateStore(initial, variable.second);
+    }
+    
+    builder.SetInsertPoint(doneBB);
+    builder.CreateRetVoid();
+    
+    return batchFunc;
+}
+
+// SarcasmBatch implementation
+SarcasmBatch::~SarcasmBatch() = default;
+
+std::unique_ptr<SarcasmBatch> SarcasmBatch::compile(const std::string& source,
+                                                    const std::vector<std::string>& inputs,
+                                                    const std::vector<std::string>& outputs,
+                                                    const CompileOptions& options) {
+    initializeNativeTargetOnce();
+    
+    std::unique_ptr<SarcasmBatch> batch(new SarcasmBatch());
+    batch->inputNames = inputs;
+    batch->outputNames = outputs;
+    batch->program = std::make_unique<CompiledProgram>();
+    CompiledProgram& compiled = *batch->program;
+    compiled.context = std::make_unique<LLVMContext>();
+    auto module = std::make_unique<Module>("SarcasmLang", *compiled.context);
+    
+    std::vector<std::unique_ptr<ASTNode>> program;
+    if (!parseSource(source, options.frontendThreads, program)) {
+        return nullptr;
+    }
+    
+    CodeGenContext cg(*compiled.context, module.get());
+    cg.setNumericProfile(options.numericProfile);
+    Function* batchFunc = emitBatch(cg, program, inputs, outputs);
+    
+    if (verifyFunction(*batchFunc, &errs())) {
+        std::cerr << "smarty: Function verification failed, congratulations!" << std::endl;
+        return nullptr;
+    }
+    
+    // The whole point of batch mode is letting the optimizer at the row loop
+    CompileOptions batchOptions = options;
+    batchOptions.optimize = true;
+    if (!createEngine(compiled, std::move(module), batchOptions)) {
+        return nullptr;
+    }
+    
+    batch->entry = reinterpret_cast<SarcasmBatchFn>(
+        compiled.engine->getFunctionAddress("sarcasm_batch"));
+    if (!batch->entry) {
+        std::cerr << "genius: JIT lost your program somewhere, impressive" << std::endl;
+        return nullptr;
+    }
+    compiled.variables = std::move(cg.variables);
+    
+    return batch;
+}
+
+// SarcasmColumns implementation
+SarcasmColumns::~SarcasmColumns() {
+    for (const Mapping& mapping : mappings) {
+        munmap(mapping.data, mapping.size);
+    }
+}
+
+bool SarcasmColumns::addColumn(const std::string& name, const double* data, size_t rows) {
+    if (columns.count(name)) {
+        std::cerr << "goldfish_brain: Column '" << name << "' was loaded twice" << std::endl;
+        return false;
+    }
+    if (!columns.empty() && rows != rowCount) {
+        std::cerr << "bonehead: Column '" << name << "' has " << rows
+                  << " rows but the others have " << rowCount << std::endl;
+        return false;
+    }
+    rowCount = rows;
+    columns[name] = data;
+    columnNames.push_back(name);
+    return true;
+}
+
+bool SarcasmColumns::parseCsv(const std::string& path, const char* text, size_t size) {
+    const char* end = text + size;
+    const char* cursor = text;
+    
+    // Fields are copied out before strtod, since the mapping isn't NUL-terminated
+    auto nextField = [&](std::string& field) {
+        const char* start = cursor;
+        while (cursor < end && *cursor != ',' && *cursor != '\n') cursor++;
+        const char* stop = cursor;
+        while (stop > start && (stop[-1] == '\r' || stop[-1] == ' ')) stop--;
+        while (start < stop && *start == ' ') start++;
+        field.assign(start, stop);
+        bool lastInLine = cursor >= end || *cursor == '\n';
+        if (cursor < end) cursor++;
+        return lastInLine;
+    };
+    
+    std::vector<std::string> header;
+    std::string field;
+    while (cursor < end) {
+        bool lastInLine = nextField(field);
+        header.push_back(field);
+        if (lastInLine) break;
+    }
+    if (header.empty()) {
+        std::cerr << "dummy: '" << path << "' doesn't even have a header row" << std::endl;
+        return false;
+    }
+    
+    std::vector<std::unique_ptr<std::vector<double>>> values;
+    for (size_t i = 0; i < header.size(); ++i) {
+        values.push_back(std::make_unique<std::vector<double>>());
+        values.back()->reserve(size / (header.size() * 4));
+    }
+    
+    size_t line = 1;
+    while (cursor < end) {
+        line++;
+        if (*cursor == '\n' || *cursor == '\r') {
+            cursor++;
+            continue;
+        }
+        for (size_t i = 0; i < header.size(); ++i) {
+            bool lastInLine = nextField(field);
+            char* parsedEnd = nullptr;
+            double value = std::strtod(field.c_str(), &parsedEnd);
+            if (field.empty() || *parsedEnd != '\0' || lastInLine != (i + 1 == header.size())) {
+                std::cerr << "peasant: '" << path << "' line " << line
+                          << " isn't a row of " << header.size() << " numbers" << std::endl;
+                return false;
+            }
+            values[i]->push_back(value);
+        }
+    }
+    
+    for (size_t i = 0; i < header.size(); ++i) {
+        if (!addColumn(header[i], values[i]->data(), values[i]->size())) return false;
+        parsed.push_back(std::move(values[i]));
+    }
+    return true;
+}
+
+bool SarcasmColumns::load(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "genius: Can't open column file '" << path
+                  << "' - did you forget it exists?" << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        std::cerr << "genius: Can't even stat '" << path << "'" << std::endl;
+        return false;
+    }
+    
+    size_t size = static_cast<size_t>(info.st_size);
+    void* data = nullptr;
+    if (size > 0) {
+        data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            std::cerr << "genius: Can't map '" << path << "' into memory" << std::endl;
+            return false;
+        }
+        madvise(data, size, MADV_SEQUENTIAL);
+        mappings.push_back({data, size});
+    }
+    close(fd);
+    
+    std::string name = path.substr(path.find_last_of('/') + 1);
+    std::string extension;
+    size_t dot = name.find_last_of('.');
+    if (dot != std::string::npos) {
+        extension = name.substr(dot);
+        name = name.substr(0, dot);
+    }
+    
+    if (extension == ".csv") {
+        return parseCsv(path, static_cast<const char*>(data), size);
+    }
+    if (size % sizeof(double) != 0) {
+        std::cerr << "dummy: '" << path << "' isn't a whole number of doubles" << std::endl;
+        return false;
+    }
+    return addColumn(name, static_cast<const double*>(data), size / sizeof(double));
+}
+
+const double* SarcasmColumns::column(const std::string& name) const {
+    auto it = columns.find(name);
+    return it == columns.end() ? nullptr : it->second;
+}
+
+// SarcasmScheduler implementation
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+SarcasmScheduler::SarcasmScheduler(unsigned workerCount, const CompileOptions& options,
+                                   int64_t sliceFuel, int64_t fuelBudget)
+    : options(options), sliceFuel(sliceFuel), fuelBudget(fuelBudget) {
+    this->options.yieldAtBackEdges = true;
+    for (unsigned i = 0; i < std::max(workerCount, 1u); ++i) {
+        workers.emplace_back(&SarcasmScheduler::workerLoop, this);
+    }
+}
+
+SarcasmScheduler::~SarcasmScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// Compiles the task on first use, then runs one slice of it
+bool SarcasmScheduler::runSlice(Task& task) {
+    ProgramMetrics& metrics = task.result.metrics;
+    if (!task.started) {
+        task.started = true;
+        metrics.queuedMs = millisecondsSince(task.submitted);
+        
+        Clock::time_point compileStart = Clock::now();
+        task.compiled = compileProgram(task.source, options);
+        metrics.compileMs = millisecondsSince(compileStart);
+        if (!task.compiled) return true;
+        
+        task.storage.assign(task.compiled->variables.size(), 0.0);
+        for (double& slot : task.storage) {
+            task.slots.push_back(&slot);
+        }
+        task.runtime.output = &task.result.output;
+    }
+    
+    // One unit past the budget: a program that needs exactly the budget still
+    // gets back to its loop condition, and only a program that takes one more
+    // back-edge runs dry
+    int64_t fuel = sliceFuel;
+    if (fuelBudget > 0) {
+        fuel = std::min(fuel, fuelBudget - static_cast<int64_t>(metrics.backEdges) + 1);
+    }
+    task.runtime.fuel = fuel;
+    Clock::time_point sliceStart = Clock::now();
+    task.resume = task.compiled->entry(task.slots.data(), &task.runtime, task.resume);
+    metrics.runMs += millisecondsSince(sliceStart);
+    metrics.slices++;
+    metrics.backEdges += static_cast<uint64_t>(fuel - task.runtime.fuel);
+    
+    if (task.resume != 0) {
+        if (fuelBudget == 0 || static_cast<int64_t>(metrics.backEdges) <= fuelBudget) return false;
+        task.result.outOfFuel = true;
+        task.compiled.reset();
+        return true;
+    }
+    
+    task.result.ok = true;
+    for (size_t i = 0; i < task.storage.size(); ++i) {
+        task.result.variables[task.compiled->variables[i]] = task.storage[i];
+    }
+    task.compiled.reset();
+    return true;
+}
+
+void SarcasmScheduler::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        workAvailable.wait(lock, [this] { return stopping || !runQueue.empty(); });
+        if (runQueue.empty()) return;
+        
+        Task* task = runQueue.front();
+        runQueue.pop_front();
+        bool cancelled = stopping || task->cancelRequested;
+        lock.unlock();
+        bool finished = true;
+        if (cancelled) {
+            task->result.cancelled = true;
+            task->compiled.reset();
+        } else {
+            finished = runSlice(*task);
+        }
+        if (finished) {
+            task->result.metrics.latencyMs = millisecondsSince(task->submitted);
+        }
+        lock.lock();
+        
+        if (!finished) {
+            runQueue.push_back(task);
+            workAvailable.notify_one();
+        } else if (--pending == 0) {
+            allDone.notify_all();
+        }
+    }
+}
+
+size_t SarcasmScheduler::submit(const std::string& name, const std::string& source) {
+    auto task = std::make_unique<Task>();
+    task->result.name = name;
+    task->source = source;
+    task->submitted = Clock::now();
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    runQueue.push_back(task.get());
+    tasks.push_back(std::move(task));
+    pending++;
+    workAvailable.notify_one();
+    return tasks.size() - 1;
+}
+
+void SarcasmScheduler::cancel(size_t id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks[id]->cancelRequested = true;
+}
+
+void SarcasmScheduler::cancelAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& task : tasks) {
+        task->cancelRequested = true;
+    }
+}
+
+void SarcasmScheduler::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [this] { return pending == 0; });
+}
+
+bool SarcasmScheduler::wait(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return allDone.wait_for(lock, timeout, [this] { return pending == 0; });
+}
+
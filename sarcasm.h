@@ -0,0 +1,310 @@
+#ifndef SARCASM_H
+#define SARCASM_H
+
+// libsarcasm - compile SarcasmLang once, then run it from your own code as
+// often as you like without spawning a process or parsing printf output.
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace llvm {
+class LLVMContext;
+class ExecutionEngine;
+}
+
+// Runtime state shared between the host and a running program. The JITed code
+// reads `fuel` directly at loop back-edges, so it must stay the first member.
+struct SarcasmRuntime {
+    int64_t fuel;           // Back-edges left before the program yields
+    std::string* output;    // Captured output, or nullptr for stdout
+};
+
+// Compiled program entry: copies variables in from `slots`, runs until it
+// finishes (returns 0) or runs out of fuel (returns the resume point to pass
+// back in on the next call), then copies variables back out.
+typedef int32_t (*SarcasmEntryFn)(double** slots, SarcasmRuntime* runtime, int32_t resume);
+
+// Called by generated code for every show/display/reveal/output statement
+extern "C" void sarcasm_print(SarcasmRuntime* runtime, const char* format, double value);
+
+// How much freedom the optimizer gets with floating point
+enum NumericProfile {
+    NUMERIC_STRICT,     // IEEE, bit-exact with evaluating each operation in order
+    NUMERIC_CONTRACT,   // Multiplies and adds may fuse into FMAs
+    NUMERIC_FAST        // Full fast-math: reassociation, no NaN/Inf/signed zero care
+};
+
+struct CompileOptions {
+    bool verbose = false;           // Print compilation comments and IR
+    bool yieldAtBackEdges = false;  // Let a scheduler preempt long loops
+    unsigned codegenThreads = 1;    // Split the program and run the backend in parallel
+    unsigned frontendThreads = 1;   // Lex and parse large sources in parallel
+    bool optimize = false;          // Run the O3 pipeline before JITing
+    NumericProfile numericProfile = NUMERIC_STRICT;
+    // CPU to generate code for: empty means the host when JITing and a
+    // generic baseline for objects, "host" means the host either way, and
+    // anything else is an LLVM CPU name such as "haswell"
+    std::string cpu;
+    bool multiversion = false;      // Objects only: add x86-64 AVX2/AVX-512 clones of loops;
+                                    // needs a generic `cpu` for the fallback
+};
+
+// A JITed program. The engine owns the module, so it must be destroyed
+// before the context the module lives in.
+struct CompiledProgram {
+    std::unique_ptr<llvm::LLVMContext> context;
+    std::unique_ptr<llvm::ExecutionEngine> engine;
+    SarcasmEntryFn entry = nullptr;
+    std::vector<std::string> variables;
+
+    CompiledProgram();
+    ~CompiledProgram();
+};
+
+// Returns nullptr (after complaining on stderr) if the program doesn't parse all the
+// way through or doesn't compile
+std::unique_ptr<CompiledProgram> compileProgram(const std::string& source, const CompileOptions& options);
+
+// Writes a standalone, always optimized object with its own `main`; link it
+// with `cc file.o`. With `multiversion`, every function containing a loop is
+// also compiled for newer x86-64 CPUs and the best version is picked on the
+// first call, so one binary runs well on both old and new machines. The
+// fallback is built for generic x86-64, so any other `cpu` is rejected.
+bool compileToObject(const std::string& source, const std::string& path, const CompileOptions& options);
+
+// The classic CLI path: compile, print the IR, run once on stdout. False if
+// the program didn't compile.
+bool compileAndRun(const std::string& source, CompileOptions options = CompileOptions());
+
+std::string generateRandomInsult();
+
+// A script compiled once and run as many times as the host wants. Variables
+// live in the script's own storage unless bound to host memory, in which case
+// every run reads its inputs from and writes its results to that memory.
+//
+//     auto script = SarcasmScript::compile("genius: y = x times 2\n");
+//     double x = 21, y = 0;
+//     script->bind("x", &x);
+//     script->bind("y", &y);
+//     script->run();    // y == 42
+class SarcasmScript {
+private:
+    std::unique_ptr<CompiledProgram> program;
+    std::vector<double> storage;
+    std::vector<double*> slots;
+    SarcasmRuntime runtime;
+
+    SarcasmScript(std::unique_ptr<CompiledProgram> program);
+
+public:
+    ~SarcasmScript();
+
+    static std::unique_ptr<SarcasmScript> compile(const std::string& source,
+                                                  const CompileOptions& options = CompileOptions());
+
+    // Index of a variable in the script, or -1 if it never mentions it
+    int slotIndex(const std::string& name) const;
+
+    // Points the variable at host memory; false if the script has no such variable
+    bool bind(const std::string& name, double* location);
+    void unbind(const std::string& name);
+
+    // Where the variable currently lives (bound host memory or script storage)
+    double* lookup(const std::string& name);
+    double get(const std::string& name) const;
+    void set(const std::string& name, double value);
+
+    // Send show/display/... output into `output` instead of stdout
+    void captureOutput(std::string* output) {
+        runtime.output = output;
+    }
+
+    const std::vector<std::string>& variables() const {
+        return program->variables;
+    }
+
+    void run() {
+        program->entry(slots.data(), &runtime, 0);
+    }
+};
+
+// Batch entry: runs the script body once per row, reading `inputs[k][row]`
+// and writing `outputs[k][row]` in the order the names were given to compile()
+typedef void (*SarcasmBatchFn)(const double* const* inputs, double* const* outputs,
+                               SarcasmRuntime* runtime, int64_t rows);
+
+// A script used as a per-record formula. Instead of one JIT call per record,
+// the body is wrapped in a generated loop over rows and run through the
+// optimizer, so LLVM can unroll and vectorize across records. Every row
+// starts with the input variables set from their columns and everything else
+// at 0; the output variables are stored to their columns at the end of it.
+class SarcasmBatch {
+private:
+    std::unique_ptr<CompiledProgram> program;
+    SarcasmBatchFn entry = nullptr;
+    std::vector<std::string> inputNames;
+    std::vector<std::string> outputNames;
+
+    SarcasmBatch() = default;
+
+public:
+    ~SarcasmBatch();
+
+    static std::unique_ptr<SarcasmBatch> compile(const std::string& source,
+                                                 const std::vector<std::string>& inputs,
+                                                 const std::vector<std::string>& outputs,
+                                                 const CompileOptions& options = CompileOptions());
+
+    const std::vector<std::string>& inputs() const {
+        return inputNames;
+    }
+
+    const std::vector<std::string>& outputs() const {
+        return outputNames;
+    }
+
+    void run(const double* const* inputColumns, double* const* outputColumns, int64_t rows,
+             std::string* output = nullptr) {
+        SarcasmRuntime runtime = {INT64_MAX, output};
+        entry(inputColumns, outputColumns, &runtime, rows);
+    }
+};
+
+// Named columns of doubles loaded from disk. A raw `.f64` file (native-endian
+// doubles, named after the file) is mapped and used in place; a `.csv` file
+// with a header row is mapped and parsed into one column per header field.
+class SarcasmColumns {
+private:
+    struct Mapping {
+        void* data;
+        size_t size;
+    };
+
+    std::vector<Mapping> mappings;
+    std::vector<std::unique_ptr<std::vector<double>>> parsed;
+    std::vector<std::string> columnNames;
+    std::map<std::string, const double*> columns;
+    size_t rowCount = 0;
+
+    bool addColumn(const std::string& name, const double* data, size_t rows);
+    bool parseCsv(const std::string& path, const char* text, size_t size);
+
+public:
+    SarcasmColumns() = default;
+    SarcasmColumns(const SarcasmColumns&) = delete;
+    SarcasmColumns& operator=(const SarcasmColumns&) = delete;
+    ~SarcasmColumns();
+
+    bool load(const std::string& path);
+
+    // nullptr if no column has that name
+    const double* column(const std::string& name) const;
+
+    const std::vector<std::string>& names() const {
+        return columnNames;
+    }
+
+    size_t rows() const {
+        return rowCount;
+    }
+};
+
+// Per-program numbers collected by the scheduler
+struct ProgramMetrics {
+    double queuedMs = 0;     // Submission until a worker first picked it up
+    double compileMs = 0;
+    double runMs = 0;        // Time spent executing slices, summed
+    double latencyMs = 0;    // Submission until completion
+    uint64_t slices = 0;
+    uint64_t backEdges = 0;  // Loop iterations executed
+};
+
+struct ScheduledResult {
+    std::string name;
+    bool ok = false;
+    bool outOfFuel = false;  // Stopped trying to loop past the per-program fuel budget
+    bool cancelled = false;  // Stopped by cancel() or the scheduler shutting down
+    std::string output;
+    std::map<std::string, double> variables;
+    ProgramMetrics metrics;
+};
+
+// Runs many programs concurrently on a fixed pool of worker threads. Each
+// program is compiled with fuel checks on its loop back-edges; when a slice
+// runs out of fuel the program returns to the back of the run queue, so a
+// long-running script can't starve the short ones behind it. A program that
+// never ends is stopped by the fuel budget, by cancel(), or when the
+// scheduler is destroyed, whichever comes first.
+class SarcasmScheduler {
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Task {
+        ScheduledResult result;
+        std::string source;
+        std::unique_ptr<CompiledProgram> compiled;
+        std::vector<double> storage;
+        std::vector<double*> slots;
+        SarcasmRuntime runtime = {0, nullptr};
+        int32_t resume = 0;
+        bool started = false;
+        bool cancelRequested = false;  // Guarded by the scheduler's mutex
+        Clock::time_point submitted;
+    };
+
+    std::vector<std::unique_ptr<Task>> tasks;
+    std::deque<Task*> runQueue;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    size_t pending = 0;
+    bool stopping = false;
+    CompileOptions options;
+    int64_t sliceFuel;
+    int64_t fuelBudget;
+
+    bool runSlice(Task& task);
+    void workerLoop();
+
+public:
+    // Every program is compiled with `options` (plus back-edge yielding).
+    // `fuelBudget` caps the loop iterations each program may run in total: a
+    // program is stopped when it starts one more; 0 lets programs run forever.
+    explicit SarcasmScheduler(unsigned workerCount, const CompileOptions& options = CompileOptions(),
+                              int64_t sliceFuel = 10000, int64_t fuelBudget = 0);
+
+    // Stops whatever is still running at the end of its current slice
+    ~SarcasmScheduler();
+
+    size_t submit(const std::string& name, const std::string& source);
+
+    // Stops the program at the end of its current slice (or before it
+    // starts); it then counts as finished, with `cancelled` set
+    void cancel(size_t id);
+    void cancelAll();
+
+    // Blocks until every submitted program has finished
+    void wait();
+
+    // Same, but gives up after `timeout`; false if programs are still running
+    bool wait(std::chrono::milliseconds timeout);
+
+    const ScheduledResult& result(size_t id) const {
+        return tasks[id]->result;
+    }
+
+    size_t size() const {
+        return tasks.size();
+    }
+};
+
+#endif // SARCASM_H
@@ -0,0 +1,196 @@
+// Numeric profile checks: strict mode must stay bit-exact no matter how hard
+// the optimizer works, contract mode must really fuse, and the benchmark
+// shows what each profile buys on reduction-heavy scripts.
+//
+//     numeric_profiles_test [iterations]
+
+#include "sarcasm.h"
+
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+// Latency-bound: every iteration waits for the previous sum
+static const char* reductionScript =
+    "genius: s = 0\n"
+    "moron: i = 0\n"
+    "idiot: whatever i < n do {\n"
+    "    dummy: s = s plus i times 0.1 plus 0.3\n"
+    "    doofus: i = i plus 1\n"
+    "}\n";
+
+// Throughput-bound: a degree-6 polynomial per iteration, where six
+// multiply-adds can become six FMAs
+static const char* polynomialScript =
+    "genius: s = 0\n"
+    "moron: i = 0\n"
+    "idiot: whatever i < n do {\n"
+    "    dummy: x = i times 0.000001\n"
+    "    dimwit: p = (((((x times 0.5 plus 0.25) times x plus 0.125) times x plus 0.0625) times x\n"
+    "                plus 0.03125) times x plus 0.015625) times x plus 0.0078125\n"
+    "    numbskull: s = s plus p\n"
+    "    doofus: i = i plus 1\n"
+    "}\n";
+
+// a * b - c with c the rounded product: zero when rounded twice, the
+// product's rounding error when fused
+static const char* fmaScript = "genius: r = a times b minus c\n";
+
+static uint64_t bitsOf(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// The JIT targets the host CPU, so contraction needs FMA on the host
+static bool hostHasFma() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_cpu_supports("fma");
+#else
+    return true;
+#endif
+}
+
+// The reduction loop in C++, one rounded operation at a time. The volatile
+// keeps the compiler from fusing the multiply into the add.
+static double naiveReductionSum(double n) {
+    double s = 0;
+    for (double i = 0; i < n; i = i + 1) {
+        volatile double product = i * 0.1;
+        s = s + product + 0.3;
+    }
+    return s;
+}
+
+// sum of (i * 0.1 + 0.3) for i < n, without accumulated rounding
+static double exactReductionSum(double n) {
+    long double count = n;
+    return static_cast<double>(0.1L * count * (count - 1) / 2 + 0.3L * count);
+}
+
+struct Measurement {
+    bool ok = false;
+    double sum = 0;
+    double ms = 0;
+};
+
+static Measurement runLoop(const char* source, const CompileOptions& options, double n) {
+    Measurement measurement;
+    auto script = SarcasmScript::compile(source, options);
+    if (!script) return measurement;
+
+    double s = 0;
+    script->bind("n", &n);
+    script->bind("s", &s);
+    auto start = std::chrono::steady_clock::now();
+    script->run();
+    measurement.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    measurement.sum = s;
+    measurement.ok = true;
+    return measurement;
+}
+
+static bool runFma(const CompileOptions& options, double a, double b, double c, double& r) {
+    auto script = SarcasmScript::compile(fmaScript, options);
+    if (!script) return false;
+    script->bind("a", &a);
+    script->bind("b", &b);
+    script->bind("c", &c);
+    script->bind("r", &r);
+    script->run();
+    return true;
+}
+
+static const NumericProfile profiles[] = {NUMERIC_STRICT, NUMERIC_CONTRACT, NUMERIC_FAST};
+static const char* profileNames[] = {"strict", "contract", "fast"};
+
+static Measurement bestOfThree(const char* source, NumericProfile profile, double n) {
+    CompileOptions options;
+    options.optimize = true;
+    options.numericProfile = profile;
+    Measurement best;
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        Measurement measurement = runLoop(source, options, n);
+        if (!best.ok || measurement.ms < best.ms) best = measurement;
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    double n = argc > 1 ? std::atof(argv[1]) : 20000000;
+    int failures = 0;
+
+    // Fusion changes these bits, so strict can't quietly start contracting
+    volatile double a = 0.1, b = 10;
+    volatile double product = a * b;
+    double c = product;
+    double unfused = product - c;
+    double fused = std::fma(a, b, -c);
+    std::printf("a*b-c: %.17g rounded twice, %.17g fused\n", unfused, fused);
+    for (NumericProfile profile : {NUMERIC_STRICT, NUMERIC_CONTRACT}) {
+        for (bool optimize : {false, true}) {
+            CompileOptions options;
+            options.optimize = optimize;
+            options.numericProfile = profile;
+            double r = -1;
+            bool ok = runFma(options, a, b, c, r);
+            const char* name = profile == NUMERIC_STRICT ? "strict" : "contract";
+            if (profile == NUMERIC_CONTRACT && !hostHasFma()) {
+                std::printf("SKIP %s%s: no FMA on this CPU\n", name, optimize ? " -O" : "");
+                continue;
+            }
+            double expected = profile == NUMERIC_STRICT ? unfused : fused;
+            bool exact = ok && bitsOf(r) == bitsOf(expected);
+            std::printf("%s %s%s a*b-c: %.17g\n", exact ? "PASS" : "FAIL", name, optimize ? " -O" : "", r);
+            if (!exact) failures++;
+        }
+    }
+
+    // Strict: every combination of optimizer and backend threads agrees with
+    // the naive loop to the last bit
+    double naive = naiveReductionSum(n);
+    double exact = exactReductionSum(n);
+    std::printf("reduction over %.0f iterations: naive %.17g, exact %.17g\n", n, naive, exact);
+    for (bool optimize : {false, true}) {
+        for (unsigned threads : {1u, 4u}) {
+            CompileOptions options;
+            options.optimize = optimize;
+            options.codegenThreads = threads;
+            Measurement strict = runLoop(reductionScript, options, n);
+            bool same = strict.ok && bitsOf(strict.sum) == bitsOf(naive);
+            std::printf("%s strict%s, %u codegen thread%s: %.17g\n", same ? "PASS" : "FAIL",
+                        optimize ? " -O" : "", threads, threads == 1 ? "" : "s", strict.sum);
+            if (!same) failures++;
+        }
+    }
+
+    // Benchmark, everything optimized. Relaxed profiles may round differently,
+    // but no worse than naive summation can: n rounding errors of the sum.
+    double tolerance = n * DBL_EPSILON * std::fabs(exact);
+    const char* scriptNames[] = {"reduction", "polynomial"};
+    const char* scripts[] = {reductionScript, polynomialScript};
+    for (size_t k = 0; k < 2; ++k) {
+        double strictMs = 0;
+        for (size_t p = 0; p < 3; ++p) {
+            Measurement best = bestOfThree(scripts[k], profiles[p], n);
+            if (p == 0) strictMs = best.ms;
+            bool close = best.ok && (k != 0 || std::fabs(best.sum - exact) <= tolerance);
+            std::printf("%s %-10s %-8s %9.3f ms  %5.2fx strict  %.17g\n", close ? "PASS" : "FAIL",
+                        scriptNames[k], profileNames[p], best.ms, best.ms > 0 ? strictMs / best.ms : 0.0,
+                        best.sum);
+            if (!close) failures++;
+        }
+    }
+
+    if (failures) {
+        std::printf("%d check%s failed, the numbers are lying to you\n", failures, failures == 1 ? "" : "s");
+        return 1;
+    }
+    return 0;
+}